@@ -5,6 +5,8 @@ void init_node(Node *node, int node_id, int num_resources) {
     node->node_id = node_id;
     node->num_resources = num_resources;
     node->num_processes = 0;
+    node->trace = NULL;
+    InitializeCriticalSection(&node->lock);
     
     // Initialize available resources
     for (int i = 0; i < num_resources; i++) {
@@ -21,7 +23,149 @@ void init_node(Node *node, int node_id, int num_resources) {
             node->processes[i].max[j] = 0;
             node->processes[i].need[j] = 0;
         }
+        node->process_component[i] = -1;
     }
+    node->num_components = 0;
+    node->grouped_processes = 0;
+}
+
+// Find the root of a resource in the union-find forest
+static int find_root(int *parent, int r) {
+    while (parent[r] != r) {
+        parent[r] = parent[parent[r]];
+        r = parent[r];
+    }
+    return r;
+}
+
+// Regroup processes and resources into independent components.
+// Two active processes share a component when their nonzero max rows
+// overlap, so a request can only affect the safety of its own component.
+// The new grouping is built locally and published under node->lock.
+void update_components(Node *node) {
+    EnterCriticalSection(&node->lock);
+    
+    int parent[MAX_RESOURCES];
+    bool claimed[MAX_RESOURCES];
+    
+    for (int j = 0; j < node->num_resources; j++) {
+        parent[j] = j;
+        claimed[j] = false;
+    }
+    
+    // Union every resource that appears in the same process's max row
+    for (int i = 0; i < node->num_processes; i++) {
+        if (node->processes[i].is_completed) {
+            continue;
+        }
+        int first = -1;
+        for (int j = 0; j < node->num_resources; j++) {
+            if (node->processes[i].max[j] > 0) {
+                claimed[j] = true;
+                if (first < 0) {
+                    first = j;
+                } else {
+                    parent[find_root(parent, j)] = find_root(parent, first);
+                }
+            }
+        }
+    }
+    
+    // Number the components densely by their root resource
+    Component components[MAX_RESOURCES];
+    int resource_component[MAX_RESOURCES];
+    int root_component[MAX_RESOURCES];
+    int num_components = 0;
+    for (int j = 0; j < node->num_resources; j++) {
+        root_component[j] = -1;
+    }
+    for (int j = 0; j < node->num_resources; j++) {
+        resource_component[j] = -1;
+        if (!claimed[j]) {
+            continue;
+        }
+        int root = find_root(parent, j);
+        if (root_component[root] < 0) {
+            root_component[root] = num_components;
+            components[num_components].num_processes = 0;
+            components[num_components].num_resources = 0;
+            num_components++;
+        }
+        Component *component = &components[root_component[root]];
+        component->resources[component->num_resources++] = j;
+        resource_component[j] = root_component[root];
+    }
+    
+    // A process belongs to the component of any resource it claims
+    int process_component[MAX_PROCESSES];
+    for (int i = 0; i < node->num_processes; i++) {
+        process_component[i] = -1;
+        if (node->processes[i].is_completed) {
+            continue;
+        }
+        for (int j = 0; j < node->num_resources; j++) {
+            if (node->processes[i].max[j] > 0) {
+                Component *component = &components[resource_component[j]];
+                component->processes[component->num_processes++] = i;
+                process_component[i] = resource_component[j];
+                break;
+            }
+        }
+    }
+    
+    memcpy(node->components, components, num_components * sizeof(Component));
+    memcpy(node->process_component, process_component, node->num_processes * sizeof(int));
+    node->num_components = num_components;
+    node->grouped_processes = node->num_processes;
+    
+    LeaveCriticalSection(&node->lock);
+}
+
+// Check if one component is safe, using only its share of available
+bool is_component_safe(Node *node, int component) {
+    Component *members = &node->components[component];
+    int num_procs = members->num_processes;
+    int num_res = members->num_resources;
+    int work[MAX_RESOURCES];
+    bool finish[MAX_PROCESSES];
+    
+    // Initialize work and finish arrays
+    for (int k = 0; k < num_res; k++) {
+        work[k] = node->available[members->resources[k]];
+    }
+    for (int p = 0; p < num_procs; p++) {
+        finish[p] = false;
+    }
+    
+    // Find a process that can be completed
+    int remaining = num_procs;
+    bool found;
+    do {
+        found = false;
+        for (int p = 0; p < num_procs; p++) {
+            if (!finish[p]) {
+                Process *proc = &node->processes[members->processes[p]];
+                bool can_complete = true;
+                for (int k = 0; k < num_res; k++) {
+                    if (proc->need[members->resources[k]] > work[k]) {
+                        can_complete = false;
+                        break;
+                    }
+                }
+                
+                if (can_complete) {
+                    for (int k = 0; k < num_res; k++) {
+                        work[k] += proc->allocation[members->resources[k]];
+                    }
+                    finish[p] = true;
+                    remaining--;
+                    found = true;
+                }
+            }
+        }
+    } while (found && remaining > 0);
+    
+    return remaining == 0;
 }
 
 // Check if the current state is safe
@@ -71,8 +215,8 @@ bool is_safe_state(Node *node) {
     return true;
 }
 
-// Request resources for a process
-bool request_resources(Node *node, int process_id, int *request) {
+// Request resources for a process (caller holds node->lock)
+static bool try_request(Node *node, int process_id, int *request) {
     // Validate process ID
     if (process_id < 0 || process_id >= node->num_processes) {
         return false;
@@ -81,6 +225,7 @@ bool request_resources(Node *node, int process_id, int *request) {
     // Check if request exceeds need
     for (int i = 0; i < node->num_resources; i++) {
         if (request[i] > node->processes[process_id].need[i]) {
+            trace_record(node, TRACE_REQUEST, process_id, request, false);
             return false;
         }
     }
@@ -88,6 +233,7 @@ bool request_resources(Node *node, int process_id, int *request) {
     // Check if request exceeds available resources
     for (int i = 0; i < node->num_resources; i++) {
         if (request[i] > node->available[i]) {
+            trace_record(node, TRACE_REQUEST, process_id, request, false);
             return false;
         }
     }
@@ -99,8 +245,16 @@ bool request_resources(Node *node, int process_id, int *request) {
         node->processes[process_id].need[i] -= request[i];
     }
     
-    // Check if the new state is safe
-    if (is_safe_state(node)) {
+    // Check if the new state is safe; the request only touches resources in
+    // the process's own component, so the other components are unaffected.
+    // Processes outside any component, or a grouping made before processes
+    // were added to the table directly, get the full scan.
+    int component = node->process_component[process_id];
+    bool grouped = node->grouped_processes == node->num_processes;
+    bool safe = grouped && component >= 0 ? is_component_safe(node, component)
+                                          : is_safe_state(node);
+    if (safe) {
+        trace_record(node, TRACE_REQUEST, process_id, request, true);
         return true;
     } else {
         // Rollback the allocation
@@ -109,12 +263,21 @@ bool request_resources(Node *node, int process_id, int *request) {
             node->processes[process_id].allocation[i] -= request[i];
             node->processes[process_id].need[i] += request[i];
         }
+        trace_record(node, TRACE_REQUEST, process_id, request, false);
         return false;
     }
 }
 
-// Release resources from a process
-bool release_resources(Node *node, int process_id, int *release) {
+// Request resources for a process
+bool request_resources(Node *node, int process_id, int *request) {
+    EnterCriticalSection(&node->lock);
+    bool granted = try_request(node, process_id, request);
+    LeaveCriticalSection(&node->lock);
+    return granted;
+}
+
+// Release resources from a process (caller holds node->lock)
+static bool try_release(Node *node, int process_id, int *release) {
     // Validate process ID
     if (process_id < 0 || process_id >= node->num_processes) {
         return false;
@@ -123,6 +286,7 @@ bool release_resources(Node *node, int process_id, int *release) {
     // Check if release is valid
     for (int i = 0; i < node->num_resources; i++) {
         if (release[i] > node->processes[process_id].allocation[i]) {
+            trace_record(node, TRACE_RELEASE, process_id, release, false);
             return false;
         }
     }
@@ -134,23 +298,108 @@ bool release_resources(Node *node, int process_id, int *release) {
         node->processes[process_id].need[i] += release[i];
     }
     
+    trace_record(node, TRACE_RELEASE, process_id, release, true);
     return true;
 }
 
+// Release resources from a process
+bool release_resources(Node *node, int process_id, int *release) {
+    EnterCriticalSection(&node->lock);
+    bool released = try_release(node, process_id, release);
+    LeaveCriticalSection(&node->lock);
+    return released;
+}
+
 // Check if a request can be granted
 bool can_grant_request(Node *node, int process_id, int *request) {
-    // Make a copy of the node state
-    Node temp_node = *node;
+    EnterCriticalSection(&node->lock);
     
-    // Try to allocate resources in the temporary state
+    // Try the allocation on the live state; the lock keeps it invisible
     for (int i = 0; i < node->num_resources; i++) {
-        temp_node.available[i] -= request[i];
-        temp_node.processes[process_id].allocation[i] += request[i];
-        temp_node.processes[process_id].need[i] -= request[i];
+        node->available[i] -= request[i];
+        node->processes[process_id].allocation[i] += request[i];
+        node->processes[process_id].need[i] -= request[i];
     }
     
-    // Check if the temporary state is safe
-    return is_safe_state(&temp_node);
+    bool safe = is_safe_state(node);
+    
+    // Rollback the trial allocation
+    for (int i = 0; i < node->num_resources; i++) {
+        node->available[i] += request[i];
+        node->processes[process_id].allocation[i] -= request[i];
+        node->processes[process_id].need[i] += request[i];
+    }
+    
+    LeaveCriticalSection(&node->lock);
+    return safe;
+}
+
+// Hand spare available resources to another node
+bool lend_resources(Node *node, int *resources) {
+    EnterCriticalSection(&node->lock);
+    
+    bool can_spare = true;
+    for (int i = 0; i < node->num_resources; i++) {
+        if (resources[i] > node->available[i]) {
+            can_spare = false;
+            break;
+        }
+    }
+    
+    if (can_spare) {
+        for (int i = 0; i < node->num_resources; i++) {
+            node->available[i] -= resources[i];
+        }
+    }
+    
+    trace_record(node, TRACE_BORROW, -1, resources, can_spare);
+    LeaveCriticalSection(&node->lock);
+    return can_spare;
+}
+
+// Add a process to the node; returns its index or -1 if the node is full
+int add_process(Node *node, int priority, int *max, int *allocation) {
+    EnterCriticalSection(&node->lock);
+    if (node->num_processes >= MAX_PROCESSES) {
+        LeaveCriticalSection(&node->lock);
+        return -1;
+    }
+    
+    int pid = node->num_processes++;
+    node->processes[pid].pid = pid;
+    node->processes[pid].priority = priority;
+    node->processes[pid].is_completed = false;
+    for (int j = 0; j < node->num_resources; j++) {
+        node->processes[pid].max[j] = max[j];
+        node->processes[pid].allocation[j] = allocation[j];
+        node->processes[pid].need[j] = max[j] - allocation[j];
+    }
+    
+    update_components(node);
+    LeaveCriticalSection(&node->lock);
+    return pid;
+}
+
+// Mark a process as finished once it needs nothing more and drop it from
+// its component. Returns false (and records nothing) if work remains.
+bool complete_process(Node *node, int process_id) {
+    if (process_id < 0 || process_id >= node->num_processes) {
+        return false;
+    }
+    
+    EnterCriticalSection(&node->lock);
+    for (int i = 0; i < node->num_resources; i++) {
+        if (node->processes[process_id].need[i] > 0) {
+            LeaveCriticalSection(&node->lock);
+            return false;
+        }
+    }
+    
+    node->processes[process_id].is_completed = true;
+    update_components(node);
+    trace_record(node, TRACE_COMPLETE, process_id, NULL, true);
+    LeaveCriticalSection(&node->lock);
+    return true;
 }
 
 // Print the current state of the system
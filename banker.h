@@ -6,11 +6,15 @@
 #include <string.h>
 #include <windows.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #define MAX_PROCESSES 10
 #define MAX_RESOURCES 10
 #define MAX_NODES 3
 
+// Opaque handle for an in-progress trace capture (see trace.c)
+typedef struct TraceWriter TraceWriter;
+
 // Structure to represent a process
 typedef struct {
     int pid;
@@ -21,6 +25,15 @@ typedef struct {
     bool is_completed;
 } Process;
 
+// Independent component: processes linked by shared nonzero max entries,
+// together with the resource types they claim
+typedef struct {
+    int processes[MAX_PROCESSES];
+    int num_processes;
+    int resources[MAX_RESOURCES];
+    int num_resources;
+} Component;
+
 // Structure to represent a node in the system
 typedef struct {
     int node_id;
@@ -28,13 +41,43 @@ typedef struct {
     Process processes[MAX_PROCESSES];
     int num_processes;
     int num_resources;
+    Component components[MAX_RESOURCES];  // At most one per resource type
+    int num_components;
+    int process_component[MAX_PROCESSES]; // -1 for completed or claim-free processes
+    int grouped_processes; // num_processes when components were last built
+    TraceWriter *trace; // NULL unless a trace capture is attached
+    CRITICAL_SECTION lock; // Serializes state changes and their trace records
 } Node;
 
+// Kinds of events recorded in a workload trace
+typedef enum {
+    TRACE_REQUEST = 0,
+    TRACE_RELEASE = 1,
+    TRACE_BORROW = 2,
+    TRACE_COMPLETE = 3
+} TraceEventType;
+
+// Decoded trace event, as returned by trace_next_event
+typedef struct {
+    uint64_t timestamp_us; // Microseconds since the capture was opened
+    int type;
+    int process_id;
+    bool granted;
+    int resources[MAX_RESOURCES];
+} TraceEvent;
+
 // Core Banker's Algorithm functions
 bool is_safe_state(Node *node);
+bool is_component_safe(Node *node, int component);
 bool request_resources(Node *node, int process_id, int *request);
 bool release_resources(Node *node, int process_id, int *release);
 bool can_grant_request(Node *node, int process_id, int *request);
+bool lend_resources(Node *node, int *resources);
+
+// Process lifecycle and component tracking
+int add_process(Node *node, int priority, int *max, int *allocation);
+bool complete_process(Node *node, int process_id);
+void update_components(Node *node);
 
 // Priority scheduling functions
 void update_priorities(Node *node);
@@ -48,6 +91,15 @@ void update_deadlock_history(Node *node, int process_id, bool was_safe);
 void print_state(Node *node);
 void init_node(Node *node, int node_id, int num_resources);
 
+// Workload trace capture and replay
+bool trace_open(Node *node, const char *path);
+void trace_close(Node *node);
+void trace_flush(Node *node);
+void trace_record(Node *node, int type, int process_id, int *resources, bool granted);
+FILE *trace_load(const char *path, Node *node);
+bool trace_next_event(FILE *file, int num_resources, TraceEvent *event);
+uint64_t ticks_to_us(LONGLONG ticks, LONGLONG frequency);
+
 // Simulation control
 extern volatile bool should_exit;
 DWORD WINAPI process_simulator(LPVOID arg);
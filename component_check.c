@@ -0,0 +1,133 @@
+#include "banker.h"
+
+// Cross-check component-scoped safety against the whole-node scan.
+// Usage: component_check [iterations] [seed]
+//   Generates random multi-tenant nodes and verifies that
+//   - every component being safe agrees with is_safe_state, and
+//   - request_resources grants exactly what a whole-node check would,
+//     both with components up to date and with processes appended to the
+//     table directly after the components were built.
+//   Exits non-zero on the first disagreement.
+
+// Random max/allocation rows; tenants usually claim disjoint types
+static void generate_rows(int num_resources, bool finished, int *max, int *allocation) {
+    for (int j = 0; j < num_resources; j++) {
+        max[j] = rand() % 4 == 0 ? rand() % 6 : 0;
+        allocation[j] = finished ? max[j] : max[j] > 0 ? rand() % (max[j] + 1) : 0;
+    }
+}
+
+// Fill a node through add_process; with edit_after_grouping, append more
+// processes directly so the stored components are out of date
+static void generate_node(Node *node, bool edit_after_grouping) {
+    int num_resources = 1 + rand() % MAX_RESOURCES;
+    int num_processes = 1 + rand() % (MAX_PROCESSES - 1);
+    init_node(node, 0, num_resources);
+
+    for (int j = 0; j < num_resources; j++) {
+        node->available[j] = rand() % 6;
+    }
+
+    bool finished[MAX_PROCESSES];
+    for (int i = 0; i < num_processes; i++) {
+        int max[MAX_RESOURCES];
+        int allocation[MAX_RESOURCES];
+        finished[i] = rand() % 5 == 0;
+        generate_rows(num_resources, finished[i], max, allocation);
+        add_process(node, 0, max, allocation);
+    }
+
+    // Processes that hold their full max are done and leave their component
+    for (int i = 0; i < num_processes; i++) {
+        if (finished[i] && !complete_process(node, i)) {
+            printf("Process %d holds its max but could not complete\n", i);
+            exit(1);
+        }
+    }
+
+    if (edit_after_grouping) {
+        int extra = 1 + rand() % (MAX_PROCESSES - num_processes);
+        for (int k = 0; k < extra; k++) {
+            int pid = node->num_processes++;
+            generate_rows(num_resources, false, node->processes[pid].max,
+                          node->processes[pid].allocation);
+            node->processes[pid].pid = pid;
+            for (int j = 0; j < num_resources; j++) {
+                node->processes[pid].need[j] =
+                    node->processes[pid].max[j] - node->processes[pid].allocation[j];
+            }
+        }
+    }
+}
+
+// Decision the original whole-node request path would make
+static bool whole_node_grant(Node *node, int process_id, int *request) {
+    for (int j = 0; j < node->num_resources; j++) {
+        if (request[j] > node->processes[process_id].need[j] ||
+            request[j] > node->available[j]) {
+            return false;
+        }
+    }
+    return can_grant_request(node, process_id, request);
+}
+
+int main(int argc, char *argv[]) {
+    long iterations = argc > 1 ? atol(argv[1]) : 200000;
+    unsigned seed = argc > 2 ? (unsigned)atol(argv[2]) : 1;
+    srand(seed);
+
+    long safe_states = 0;
+    long grouped_nodes = 0;
+    long components = 0;
+
+    for (long t = 0; t < iterations; t++) {
+        Node node;
+        bool edit_after_grouping = t % 4 == 0;
+        generate_node(&node, edit_after_grouping);
+
+        bool whole_safe = is_safe_state(&node);
+        if (!edit_after_grouping) {
+            bool all_safe = true;
+            for (int c = 0; c < node.num_components; c++) {
+                all_safe = all_safe && is_component_safe(&node, c);
+            }
+            if (all_safe != whole_safe) {
+                printf("Iteration %ld: components say %s, whole node says %s\n", t,
+                       all_safe ? "safe" : "unsafe", whole_safe ? "safe" : "unsafe");
+                return 1;
+            }
+            grouped_nodes++;
+            components += node.num_components;
+        }
+
+        // Only compare requests from a safe state; from an unsafe one the
+        // whole-node scan denies everything, while a component check
+        // still serves components that are themselves safe
+        if (!whole_safe) {
+            DeleteCriticalSection(&node.lock);
+            continue;
+        }
+        safe_states++;
+
+        int process_id = rand() % node.num_processes;
+        int request[MAX_RESOURCES];
+        for (int j = 0; j < node.num_resources; j++) {
+            request[j] = rand() % (node.processes[process_id].need[j] + 2);
+        }
+
+        bool expected = whole_node_grant(&node, process_id, request);
+        bool granted = request_resources(&node, process_id, request);
+        if (granted != expected) {
+            printf("Iteration %ld: request by process %d %s, whole node would have %s\n",
+                   t, process_id, granted ? "granted" : "denied",
+                   expected ? "granted" : "denied");
+            return 1;
+        }
+        DeleteCriticalSection(&node.lock);
+    }
+
+    printf("%ld states checked (%ld safe), %.2f components on average\n",
+           iterations, safe_states, grouped_nodes > 0 ? (double)components / grouped_nodes : 0.0);
+    printf("Component and whole-node decisions agree\n");
+    return 0;
+}
@@ -134,19 +134,7 @@ bool request_borrow(Node *source_node, Node *dest_node, int *resources) {
 
 // Process borrow request from another node
 bool process_borrow_request(Node *node, Message *request) {
-    bool can_spare = true;
-    for (int i = 0; i < node->num_resources; i++) {
-        if (request->resources[i] > node->available[i]) {
-            can_spare = false;
-            break;
-        }
-    }
-    
-    if (can_spare) {
-        for (int i = 0; i < node->num_resources; i++) {
-            node->available[i] -= request->resources[i];
-        }
-        
+    if (lend_resources(node, request->resources)) {
         Message response;
         response.source_node = node->node_id;
         response.dest_node = request->source_node;
@@ -39,18 +39,25 @@ void init_node_with_data(Node *node, int node_id, ProcessData *processes, int nu
     node->available[2] = 7;
     
     // Add processes
-    node->num_processes = num_processes;
     for (int i = 0; i < num_processes; i++) {
-        node->processes[i].pid = i;
-        node->processes[i].priority = processes[i].priority;
-        node->processes[i].is_completed = false;
-        
-        for (int j = 0; j < node->num_resources; j++) {
-            node->processes[i].max[j] = processes[i].max[j];
-            node->processes[i].allocation[j] = processes[i].allocation[j];
-            node->processes[i].need[j] = processes[i].max[j] - processes[i].allocation[j];
-        }
+        add_process(node, processes[i].priority, processes[i].max, processes[i].allocation);
+    }
+}
+
+volatile bool should_exit = false;
+static HANDLE shutdown_complete;
+
+// Console control handler: ask the simulation to stop so traces get closed
+static BOOL WINAPI console_handler(DWORD ctrl_type) {
+    should_exit = true;
+    
+    // Windows terminates the process once this returns for close/logoff/
+    // shutdown, so give main a chance to flush the traces first
+    if (ctrl_type == CTRL_CLOSE_EVENT || ctrl_type == CTRL_LOGOFF_EVENT ||
+        ctrl_type == CTRL_SHUTDOWN_EVENT) {
+        WaitForSingleObject(shutdown_complete, 4000);
     }
+    return TRUE;
 }
 
 // Simulate process requests
@@ -58,7 +65,7 @@ DWORD WINAPI process_simulator(LPVOID arg) {
     Node *node = (Node *)arg;
     srand(time(NULL));
     
-    while (1) {
+    while (!should_exit) {
         // Select a random process
         int process_id = rand() % node->num_processes;
         if (node->processes[process_id].is_completed) {
@@ -82,16 +89,7 @@ DWORD WINAPI process_simulator(LPVOID arg) {
             printf("Node %d: Process %d request granted\n", node->node_id, process_id);
             
             // Check if process is completed
-            bool completed = true;
-            for (int i = 0; i < node->num_resources; i++) {
-                if (node->processes[process_id].need[i] > 0) {
-                    completed = false;
-                    break;
-                }
-            }
-            
-            if (completed) {
-                node->processes[process_id].is_completed = true;
+            if (complete_process(node, process_id)) {
                 printf("Node %d: Process %d completed\n", node->node_id, process_id);
             }
         } else {
@@ -108,37 +106,63 @@ DWORD WINAPI process_simulator(LPVOID arg) {
     return 0;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     // Initialize nodes
     Node nodes[MAX_NODES];
-    HANDLE threads[MAX_NODES * 2]; // One for process simulator, one for message handler
+    HANDLE simulators[MAX_NODES];
+    HANDLE handlers[MAX_NODES];
     
     // Initialize nodes with different user data
     init_node_with_data(&nodes[0], 0, user1_processes, 3);
     init_node_with_data(&nodes[1], 1, user2_processes, 3);
     init_node_with_data(&nodes[2], 2, user3_processes, 3);
     
+    // Optionally capture each node's workload ("--trace" writes nodeN.trace)
+    if (argc > 1 && strcmp(argv[1], "--trace") == 0) {
+        for (int i = 0; i < MAX_NODES; i++) {
+            char path[32];
+            snprintf(path, sizeof(path), "node%d.trace", i);
+            if (!trace_open(&nodes[i], path)) {
+                printf("Node %d: running without trace capture\n", i);
+            }
+        }
+    }
+    
+    // Stop cleanly on Ctrl+C or console close so traces are flushed
+    shutdown_complete = CreateEvent(NULL, TRUE, FALSE, NULL);
+    SetConsoleCtrlHandler(console_handler, TRUE);
+    
     // Create threads for each node
     for (int i = 0; i < MAX_NODES; i++) {
-        threads[i * 2] = CreateThread(NULL, 0, process_simulator, &nodes[i], 0, NULL);
-        threads[i * 2 + 1] = CreateThread(NULL, 0, message_handler, &nodes[i], 0, NULL);
+        simulators[i] = CreateThread(NULL, 0, process_simulator, &nodes[i], 0, NULL);
+        handlers[i] = CreateThread(NULL, 0, message_handler, &nodes[i], 0, NULL);
     }
     
     // Main loop for monitoring
-    while (1) {
+    while (!should_exit) {
         for (int i = 0; i < MAX_NODES; i++) {
             print_state(&nodes[i]);
+            trace_flush(&nodes[i]);
         }
         printf("\n---\n");
-        Sleep(5000);
+        for (int t = 0; t < 50 && !should_exit; t++) {
+            Sleep(100);
+        }
     }
     
-    // Wait for all threads to complete (though they run indefinitely)
-    WaitForMultipleObjects(MAX_NODES * 2, threads, TRUE, INFINITE);
+    // Wait for the simulators; message handlers block in accept() and are
+    // left running, which is safe because trace_close takes the node lock
+    WaitForMultipleObjects(MAX_NODES, simulators, TRUE, INFINITE);
+    
+    for (int i = 0; i < MAX_NODES; i++) {
+        trace_close(&nodes[i]);
+    }
+    SetEvent(shutdown_complete);
     
     // Close thread handles
-    for (int i = 0; i < MAX_NODES * 2; i++) {
-        CloseHandle(threads[i]);
+    for (int i = 0; i < MAX_NODES; i++) {
+        CloseHandle(simulators[i]);
+        CloseHandle(handlers[i]);
     }
     
     return 0;
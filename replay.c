@@ -0,0 +1,108 @@
+#include "banker.h"
+
+// Replay a captured workload trace against the core Banker's APIs.
+// Usage: replay <trace-file> [--paced]
+//   By default events are fed as fast as possible; --paced keeps the
+//   original inter-event timing. Exits non-zero if any decision differs.
+
+static const char *event_names[] = {"request", "release", "borrow", "complete"};
+
+// Microseconds elapsed since the replay started
+static uint64_t elapsed_us(LARGE_INTEGER start, LARGE_INTEGER frequency) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return ticks_to_us(now.QuadPart - start.QuadPart, frequency.QuadPart);
+}
+
+// Apply one event to the node and return the decision the engine made
+static bool apply_event(Node *node, TraceEvent *event) {
+    switch (event->type) {
+        case TRACE_REQUEST:
+            return request_resources(node, event->process_id, event->resources);
+
+        case TRACE_RELEASE:
+            return release_resources(node, event->process_id, event->resources);
+
+        case TRACE_BORROW:
+            return lend_resources(node, event->resources);
+
+        case TRACE_COMPLETE:
+            return complete_process(node, event->process_id);
+    }
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("Usage: %s <trace-file> [--paced]\n", argv[0]);
+        return 2;
+    }
+    bool paced = argc > 2 && strcmp(argv[2], "--paced") == 0;
+
+    Node node;
+    FILE *file = trace_load(argv[1], &node);
+    if (file == NULL) {
+        return 2;
+    }
+
+    printf("Replaying node %d: %d processes, %d resources (%s)\n",
+           node.node_id, node.num_processes, node.num_resources,
+           paced ? "original pacing" : "full speed");
+
+    LARGE_INTEGER frequency, start;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+
+    TraceEvent event;
+    memset(&event, 0, sizeof(event));
+    long events = 0;
+    long mismatches = 0;
+    long counts[4] = {0};
+
+    while (trace_next_event(file, node.num_resources, &event)) {
+        if (paced) {
+            uint64_t now = elapsed_us(start, frequency);
+            if (event.timestamp_us > now) {
+                Sleep((DWORD)((event.timestamp_us - now) / 1000));
+            }
+        }
+
+        bool granted = apply_event(&node, &event);
+
+        if (granted != event.granted) {
+            if (mismatches < 10) {
+                printf("Mismatch at event %ld (t=%llu us): %s by process %d was %s, replay %s\n",
+                       events, (unsigned long long)event.timestamp_us,
+                       event.type < 4 ? event_names[event.type] : "unknown",
+                       event.process_id,
+                       event.granted ? "granted" : "denied",
+                       granted ? "granted" : "denied");
+            }
+            mismatches++;
+        }
+        if (event.type >= 0 && event.type < 4) {
+            counts[event.type]++;
+        }
+        events++;
+    }
+
+    uint64_t total_us = elapsed_us(start, frequency);
+    bool truncated = event.type < 0;
+    fclose(file);
+
+    printf("\nEvents: %ld (request %ld, release %ld, borrow %ld, complete %ld)\n",
+           events, counts[TRACE_REQUEST], counts[TRACE_RELEASE],
+           counts[TRACE_BORROW], counts[TRACE_COMPLETE]);
+    printf("Elapsed: %.3f ms", total_us / 1000.0);
+    if (!paced && total_us > 0) {
+        printf(" (%.0f events/s)", events * 1000000.0 / total_us);
+    }
+    printf("\nMismatched decisions: %ld\n", mismatches);
+
+    print_state(&node);
+
+    if (truncated) {
+        return 2;
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,266 @@
+#include "banker.h"
+
+// Trace file layout (native byte order):
+//   TraceFileHeader                     - format id and node dimensions
+//   TraceSnapshot                       - node state when capture started
+//   repeated { TraceRecordHeader, int32_t resources[num_resources] }
+
+#define TRACE_MAGIC 0x43525442 // "BTRC"
+#define TRACE_VERSION 1
+#define TRACE_BUFFER_SIZE 65536
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    int32_t node_id;
+    int32_t num_resources;
+    int32_t num_processes;
+} TraceFileHeader;
+
+typedef struct {
+    int32_t available[MAX_RESOURCES];
+    int32_t priority[MAX_PROCESSES];
+    int32_t is_completed[MAX_PROCESSES];
+    int32_t max[MAX_PROCESSES][MAX_RESOURCES];
+    int32_t allocation[MAX_PROCESSES][MAX_RESOURCES];
+} TraceSnapshot;
+
+typedef struct {
+    uint64_t timestamp_us;
+    uint8_t type;
+    uint8_t granted;
+    int16_t process_id;
+} TraceRecordHeader;
+#pragma pack(pop)
+
+// Capture state; records are staged in memory and written out in blocks.
+// All access happens under the owning node's lock, so records land in the
+// file in exactly the order their state changes were applied.
+struct TraceWriter {
+    FILE *file;
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER start;
+    int num_resources;
+    size_t used;
+    unsigned char buffer[TRACE_BUFFER_SIZE];
+};
+
+// Convert elapsed performance counter ticks to microseconds without overflow
+uint64_t ticks_to_us(LONGLONG ticks, LONGLONG frequency) {
+    return (uint64_t)(ticks / frequency) * 1000000 +
+           (uint64_t)(ticks % frequency) * 1000000 / frequency;
+}
+
+// Write out buffered records; returns false if the file could not take them
+static bool flush_buffer(TraceWriter *writer) {
+    if (writer->used > 0) {
+        size_t written = fwrite(writer->buffer, 1, writer->used, writer->file);
+        if (written != writer->used) {
+            return false;
+        }
+        writer->used = 0;
+    }
+    return fflush(writer->file) == 0;
+}
+
+// Detach and free the node's writer (caller holds node->lock)
+static bool detach_writer(Node *node) {
+    TraceWriter *writer = node->trace;
+    node->trace = NULL;
+    
+    bool ok = flush_buffer(writer);
+    if (fclose(writer->file) != 0) {
+        ok = false;
+    }
+    free(writer);
+    return ok;
+}
+
+// Stop a capture whose file can no longer be written (caller holds node->lock)
+static void abort_capture(Node *node) {
+    detach_writer(node);
+    printf("Node %d: trace write failed, capture stopped\n", node->node_id);
+}
+
+// Start capturing a node's workload to the given file
+bool trace_open(Node *node, const char *path) {
+    TraceWriter *writer = (TraceWriter *)malloc(sizeof(TraceWriter));
+    if (writer == NULL) {
+        return false;
+    }
+
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        printf("Node %d: cannot open trace file %s\n", node->node_id, path);
+        free(writer);
+        return false;
+    }
+
+    EnterCriticalSection(&node->lock);
+
+    // Record the dimensions and starting state so a replay can rebuild the node
+    TraceFileHeader header;
+    header.magic = TRACE_MAGIC;
+    header.version = TRACE_VERSION;
+    header.reserved = 0;
+    header.node_id = node->node_id;
+    header.num_resources = node->num_resources;
+    header.num_processes = node->num_processes;
+
+    TraceSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    for (int j = 0; j < node->num_resources; j++) {
+        snapshot.available[j] = node->available[j];
+    }
+    for (int i = 0; i < node->num_processes; i++) {
+        snapshot.priority[i] = node->processes[i].priority;
+        snapshot.is_completed[i] = node->processes[i].is_completed;
+        for (int j = 0; j < node->num_resources; j++) {
+            snapshot.max[i][j] = node->processes[i].max[j];
+            snapshot.allocation[i][j] = node->processes[i].allocation[j];
+        }
+    }
+
+    if (fwrite(&header, sizeof(header), 1, writer->file) != 1 ||
+        fwrite(&snapshot, sizeof(snapshot), 1, writer->file) != 1) {
+        LeaveCriticalSection(&node->lock);
+        printf("Node %d: cannot write trace file %s\n", node->node_id, path);
+        fclose(writer->file);
+        free(writer);
+        return false;
+    }
+
+    QueryPerformanceFrequency(&writer->frequency);
+    QueryPerformanceCounter(&writer->start);
+    writer->num_resources = node->num_resources;
+    writer->used = 0;
+
+    node->trace = writer;
+    LeaveCriticalSection(&node->lock);
+    return true;
+}
+
+// Stop capturing and flush any buffered events.
+// Safe while the node's threads are running: they only touch the writer
+// under node->lock, and it is detached before being freed.
+void trace_close(Node *node) {
+    EnterCriticalSection(&node->lock);
+    if (node->trace != NULL && !detach_writer(node)) {
+        printf("Node %d: trace write failed while closing capture\n", node->node_id);
+    }
+    LeaveCriticalSection(&node->lock);
+}
+
+// Push buffered events to disk so a crash loses at most what came since
+void trace_flush(Node *node) {
+    EnterCriticalSection(&node->lock);
+    if (node->trace != NULL && !flush_buffer(node->trace)) {
+        abort_capture(node);
+    }
+    LeaveCriticalSection(&node->lock);
+}
+
+// Append one event to the node's trace; a no-op when capture is off.
+// Callers hold node->lock across the state change and this call.
+void trace_record(Node *node, int type, int process_id, int *resources, bool granted) {
+    TraceWriter *writer = node->trace;
+    if (writer == NULL) {
+        return;
+    }
+
+    size_t record_size = sizeof(TraceRecordHeader) + writer->num_resources * sizeof(int32_t);
+
+    if (writer->used + record_size > TRACE_BUFFER_SIZE && !flush_buffer(writer)) {
+        abort_capture(node);
+        return;
+    }
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    TraceRecordHeader record;
+    record.timestamp_us = ticks_to_us(now.QuadPart - writer->start.QuadPart,
+                                      writer->frequency.QuadPart);
+    record.type = (uint8_t)type;
+    record.granted = granted ? 1 : 0;
+    record.process_id = (int16_t)process_id;
+
+    unsigned char *out = writer->buffer + writer->used;
+    memcpy(out, &record, sizeof(record));
+    out += sizeof(record);
+    for (int i = 0; i < writer->num_resources; i++) {
+        int32_t value = resources != NULL ? resources[i] : 0;
+        memcpy(out, &value, sizeof(value));
+        out += sizeof(value);
+    }
+    writer->used += record_size;
+}
+
+// Open a trace and rebuild the captured node's starting state
+FILE *trace_load(const char *path, Node *node) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("Cannot open trace file %s\n", path);
+        return NULL;
+    }
+
+    TraceFileHeader header;
+    TraceSnapshot snapshot;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != TRACE_MAGIC || header.version != TRACE_VERSION ||
+        header.num_resources < 0 || header.num_resources > MAX_RESOURCES ||
+        header.num_processes < 0 || header.num_processes > MAX_PROCESSES ||
+        fread(&snapshot, sizeof(snapshot), 1, file) != 1) {
+        printf("%s is not a valid trace file\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    init_node(node, header.node_id, header.num_resources);
+    node->num_processes = header.num_processes;
+    for (int j = 0; j < node->num_resources; j++) {
+        node->available[j] = snapshot.available[j];
+    }
+    for (int i = 0; i < node->num_processes; i++) {
+        node->processes[i].pid = i;
+        node->processes[i].priority = snapshot.priority[i];
+        node->processes[i].is_completed = snapshot.is_completed[i] != 0;
+        for (int j = 0; j < node->num_resources; j++) {
+            node->processes[i].max[j] = snapshot.max[i][j];
+            node->processes[i].allocation[j] = snapshot.allocation[i][j];
+            node->processes[i].need[j] = snapshot.max[i][j] - snapshot.allocation[i][j];
+        }
+    }
+    update_components(node);
+
+    return file;
+}
+
+// Read the next event from a trace opened with trace_load.
+// Returns false at the end; event->type is -1 if the trace was cut short.
+bool trace_next_event(FILE *file, int num_resources, TraceEvent *event) {
+    TraceRecordHeader record;
+    size_t got = fread(&record, 1, sizeof(record), file);
+    if (got == 0 && feof(file)) {
+        return false; // Clean end of trace
+    }
+
+    int32_t values[MAX_RESOURCES];
+    if (got != sizeof(record) ||
+        fread(values, sizeof(int32_t), num_resources, file) != (size_t)num_resources) {
+        printf("Trace is truncated or unreadable\n");
+        event->type = -1;
+        return false;
+    }
+
+    event->timestamp_us = record.timestamp_us;
+    event->type = record.type;
+    event->process_id = record.process_id;
+    event->granted = record.granted != 0;
+    for (int i = 0; i < num_resources; i++) {
+        event->resources[i] = values[i];
+    }
+    return true;
+}